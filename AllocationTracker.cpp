@@ -0,0 +1,92 @@
+#include "AllocationTracker.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace {
+    std::atomic<std::size_t> g_allocation_count{0};
+
+    void* counted_allocate(std::size_t size) {
+        g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+        return std::malloc(size == 0 ? 1 : size);
+    }
+
+    // Over-aligned types (alignas larger than max_align_t) come through here.
+    // std::aligned_alloc wants the size to be a multiple of the alignment, and
+    // MSVC has no aligned_alloc at all, so it gets _aligned_malloc instead.
+    void* counted_allocate_aligned(std::size_t size, std::align_val_t alignment) {
+        g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+        std::size_t align = static_cast<std::size_t>(alignment);
+#ifdef _WIN32
+        return _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+        std::size_t rounded = (size + align - 1) / align * align;
+        return std::aligned_alloc(align, rounded == 0 ? align : rounded);
+#endif
+    }
+
+    void aligned_free(void* ptr) {
+#ifdef _WIN32
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+}
+
+std::size_t AllocationTracker::allocation_count() {
+    return g_allocation_count.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size) {
+    if (void* ptr = counted_allocate(size)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    if (void* ptr = counted_allocate(size)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return counted_allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return counted_allocate(size);
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    if (void* ptr = counted_allocate_aligned(size, alignment)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    if (void* ptr = counted_allocate_aligned(size, alignment)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return counted_allocate_aligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return counted_allocate_aligned(size, alignment);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept { aligned_free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { aligned_free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { aligned_free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { aligned_free(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { aligned_free(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { aligned_free(ptr); }
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstddef>
+
+// Counts calls to the global operator new so the processor can report how
+// much allocator traffic each file generates.
+class AllocationTracker {
+public:
+    static std::size_t allocation_count();
+};
@@ -0,0 +1,414 @@
+#include "FileClassifier.h"
+#include "PerfectHashSet.h"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+
+using namespace std::literals;
+
+namespace {
+    constexpr std::array relevant_extensions{
+        ".py"sv, ".js"sv, ".ts"sv, ".jsx"sv, ".tsx"sv, ".html"sv, ".css"sv, ".scss"sv, ".sass"sv,
+        ".json"sv, ".yaml"sv, ".yml"sv, ".xml"sv, ".md"sv, ".txt"sv, ".csv"sv,
+        ".cpp"sv, ".hpp"sv, ".c"sv, ".h"sv, ".java"sv, ".kt"sv, ".go"sv, ".rs"sv,
+        ".php"sv, ".rb"sv, ".pl"sv, ".sql"sv, ".sh"sv, ".bat"sv, ".ps1"sv,
+        ".config"sv, ".ini"sv, ".env"sv, ".gitignore"sv, ".dockerignore"sv, ".svelte"sv,
+        ".cs"sv, ".csx"sv, ".csproj"sv, ".sln"sv, ".resx"sv, ".settings"sv
+    };
+
+    constexpr std::array relevant_filenames{
+        "Dockerfile"sv, "docker-compose.yml"sv, "package.json"sv, "requirements.txt"sv,
+        "Gemfile"sv, "Cargo.toml"sv, "pom.xml"sv, "build.gradle"sv, "Makefile"sv
+    };
+
+    constexpr std::array ignored_filenames{
+        "package-lock.json"sv, "yarn.lock"sv, "Pipfile.lock"sv, "poetry.lock"sv,
+        "composer.lock"sv, "Gemfile.lock"sv, "Cargo.lock"sv, "packages.config"sv,
+        ".gitattributes"sv, ".editorconfig"sv, ".prettierrc"sv, ".eslintrc"sv,
+        "tsconfig.json"sv, "tslint.json"sv, "babel.config.js"sv, "webpack.config.js"sv,
+        "rollup.config.js"sv, "vue.config.js"sv, "nuxt.config.js"sv, "next.config.js"sv,
+        ".babelrc"sv, ".npmrc"sv, ".yarnrc"sv, ".travis.yml"sv, "appveyor.yml"sv,
+        "circle.yml"sv, "Jenkinsfile"sv, ".gitlab-ci.yml"sv, "sonar-project.properties"sv,
+        "AssemblyInfo.cs"sv, "NuGet.Config"sv, "project.json"sv, "project.lock.json"sv
+    };
+
+    // Wildcard entries cannot live in a hash table, so they are matched one by one.
+    constexpr std::array ignored_globs{
+        "*.designer.cs"sv, "*.Designer.cs"sv, "*.nuspec"sv
+    };
+
+    struct LanguageExtension {
+        std::string_view language;
+        std::string_view extension;
+    };
+
+    // Interpreter names (as found in shebangs, with any version suffix removed)
+    // and editor mode names that mark an extensionless file as source code,
+    // each with the extension whose comment syntax its scripts should get.
+    constexpr LanguageExtension language_extensions[] = {
+        { "sh"sv, ".sh"sv }, { "bash"sv, ".sh"sv }, { "zsh"sv, ".sh"sv }, { "ksh"sv, ".sh"sv },
+        { "dash"sv, ".sh"sv }, { "fish"sv, ".sh"sv }, { "csh"sv, ".sh"sv }, { "tcsh"sv, ".sh"sv },
+        { "shell-script"sv, ".sh"sv }, { "python"sv, ".py"sv }, { "node"sv, ".js"sv }, { "nodejs"sv, ".js"sv },
+        { "deno"sv, ".js"sv }, { "bun"sv, ".js"sv }, { "javascript"sv, ".js"sv }, { "js"sv, ".js"sv },
+        { "typescript"sv, ".ts"sv }, { "ts"sv, ".ts"sv }, { "ruby"sv, ".rb"sv }, { "perl"sv, ".pl"sv },
+        { "php"sv, ".php"sv }, { "lua"sv, ".lua"sv }, { "tclsh"sv, ".tcl"sv }, { "awk"sv, ".awk"sv },
+        { "gawk"sv, ".awk"sv }, { "make"sv, ".mk"sv }, { "makefile"sv, ".mk"sv }, { "pwsh"sv, ".ps1"sv },
+        { "powershell"sv, ".ps1"sv }, { "rscript"sv, ".r"sv }, { "julia"sv, ".jl"sv }, { "groovy"sv, ".groovy"sv },
+        { "kotlin"sv, ".kt"sv }, { "scala"sv, ".scala"sv }, { "swift"sv, ".swift"sv }, { "elixir"sv, ".exs"sv },
+        { "escript"sv, ".erl"sv }, { "conf"sv, ".conf"sv }, { "yaml"sv, ".yaml"sv }, { "json"sv, ".json"sv },
+        { "dockerfile"sv, ".dockerfile"sv }, { "cmake"sv, ".cmake"sv }, { "c"sv, ".c"sv }, { "cpp"sv, ".cpp"sv },
+        { "c++"sv, ".cpp"sv }, { "java"sv, ".java"sv }, { "go"sv, ".go"sv }, { "rust"sv, ".rs"sv },
+        { "sql"sv, ".sql"sv }, { "xml"sv, ".xml"sv }, { "html"sv, ".html"sv }, { "css"sv, ".css"sv },
+        { "markdown"sv, ".md"sv }, { "ini"sv, ".ini"sv }, { "toml"sv, ".toml"sv }
+    };
+
+    template <std::size_t N>
+    constexpr std::array<std::string_view, N> languages_of(const LanguageExtension (&entries)[N]) {
+        std::array<std::string_view, N> languages{};
+        for (std::size_t i = 0; i < N; ++i) languages[i] = entries[i].language;
+        return languages;
+    }
+
+    constexpr auto script_languages = languages_of(language_extensions);
+
+    constexpr PerfectHashSet<perfect_hash_slots(relevant_extensions.size())> relevant_extension_set(relevant_extensions);
+    constexpr PerfectHashSet<perfect_hash_slots(relevant_filenames.size())> relevant_filename_set(relevant_filenames);
+    constexpr PerfectHashSet<perfect_hash_slots(ignored_filenames.size())> ignored_filename_set(ignored_filenames);
+    constexpr PerfectHashSet<perfect_hash_slots(script_languages.size())> script_language_set(script_languages);
+
+    // Longest key the case-insensitive tables accept; longer names never match.
+    constexpr std::size_t max_folded_length = 64;
+
+    // Lowercases `key` into `buffer` and returns a view of it, or an empty view
+    // if the key is too long to be in any case-insensitive table.
+    std::string_view fold_case(std::string_view key, std::array<char, max_folded_length>& buffer) {
+        if (key.size() > buffer.size()) return {};
+        for (std::size_t i = 0; i < key.size(); ++i) {
+            char c = key[i];
+            buffer[i] = (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+        }
+        return std::string_view(buffer.data(), key.size());
+    }
+
+    std::string_view trim(std::string_view str) {
+        size_t first = str.find_first_not_of(" \t\r");
+        if (std::string_view::npos == first) return {};
+        size_t last = str.find_last_not_of(" \t\r");
+        return str.substr(first, (last - first + 1));
+    }
+
+    // Returns the leading run of characters that can make up a language name.
+    std::string_view take_word(std::string_view str) {
+        size_t end = str.find_first_of(" \t\r\n:;");
+        return str.substr(0, end);
+    }
+
+    // Drops the first whitespace-separated word and any blanks after it.
+    std::string_view skip_word(std::string_view str) {
+        size_t end = str.find_first_of(" \t");
+        return end == std::string_view::npos ? std::string_view() : trim(str.substr(end));
+    }
+
+    bool equals_ignore_case(std::string_view a, std::string_view b) {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+            return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+        });
+    }
+
+    // Returns the mode named between the "-*-" markers of an Emacs modeline:
+    // either the whole block, or the value of its "mode" variable when the
+    // block is a list of "variable: value;" pairs.
+    std::string_view emacs_mode(std::string_view block) {
+        if (block.find(':') == std::string_view::npos) {
+            return trim(block);
+        }
+
+        while (!block.empty()) {
+            size_t end = block.find(';');
+            std::string_view field = block.substr(0, end);
+            block = (end == std::string_view::npos) ? std::string_view() : block.substr(end + 1);
+
+            size_t colon = field.find(':');
+            if (colon != std::string_view::npos && equals_ignore_case(trim(field.substr(0, colon)), "mode")) {
+                return trim(field.substr(colon + 1));
+            }
+        }
+        return {};
+    }
+
+    // Returns the filetype set by a Vim modeline. As in Vim, "vi:" and "vim:"
+    // must start a line or follow a blank, "ex:" must follow a blank, and the
+    // option must start the option list or follow a blank or ':'.
+    std::string_view vim_filetype(std::string_view header) {
+        auto is_blank = [](char c) { return c == ' ' || c == '\t'; };
+
+        for (std::string_view marker : { "vim:"sv, "vi:"sv, "ex:"sv }) {
+            for (size_t pos = header.find(marker); pos != std::string_view::npos; pos = header.find(marker, pos + 1)) {
+                bool line_start = pos == 0 || header[pos - 1] == '\n';
+                if (!(pos > 0 && is_blank(header[pos - 1])) && !(line_start && marker != "ex:")) continue;
+
+                std::string_view options = header.substr(pos + marker.size());
+                options = options.substr(0, options.find('\n'));
+                for (std::string_view key : { "filetype="sv, "ft="sv }) {
+                    for (size_t value = options.find(key); value != std::string_view::npos; value = options.find(key, value + 1)) {
+                        if (value == 0 || is_blank(options[value - 1]) || options[value - 1] == ':') {
+                            return take_word(options.substr(value + key.size()));
+                        }
+                    }
+                }
+            }
+        }
+        return {};
+    }
+
+    // Reduces a shebang program such as "/usr/bin/python3.11" to "python3.11".
+    std::string_view program_name(std::string_view program) {
+        size_t slash = program.find_last_of("/\\");
+        return slash == std::string_view::npos ? program : program.substr(slash + 1);
+    }
+
+    // Returns the interpreter named by a "#!" line, without its directory or
+    // version suffix: "#!/usr/bin/env -S python3.11 -u" gives "python".
+    std::string_view shebang_language(std::string_view header) {
+        if (header.substr(0, 2) != "#!") {
+            return {};
+        }
+
+        std::string_view line = trim(header.substr(2, header.find('\n') - 2));
+        std::string_view program = program_name(take_word(line));
+
+        // With env, the interpreter is the first non-option argument.
+        if (program == "env") {
+            line = skip_word(line);
+            while (!line.empty() && line[0] == '-') {
+                line = skip_word(line);
+            }
+            program = program_name(take_word(line));
+        }
+
+        size_t version = program.find_last_not_of("0123456789.-");
+        return program.substr(0, version == std::string_view::npos ? 0 : version + 1);
+    }
+
+    // Returns the mode named by an Emacs "-*- ... -*-" modeline.
+    std::string_view emacs_language(std::string_view header) {
+        // Emacs only honours the line on the first line of a file, or on the
+        // second when the first is a shebang.
+        std::string_view line = header.substr(0, header.find('\n'));
+        if (line.substr(0, 2) == "#!") {
+            size_t second = line.size() + 1;
+            if (second >= header.size()) {
+                return {};
+            }
+            line = header.substr(second);
+            line = line.substr(0, line.find('\n'));
+        }
+
+        size_t emacs = line.find("-*-");
+        if (emacs == std::string_view::npos) {
+            return {};
+        }
+
+        std::string_view block = line.substr(emacs + 3);
+        block = block.substr(0, block.find("-*-"));
+        return take_word(emacs_mode(block));
+    }
+
+    // Returns the extension whose comment syntax the processing pipeline
+    // should apply to a script in `language`, or an empty view if unknown.
+    std::string_view extension_for_language(std::string_view language) {
+        std::array<char, max_folded_length> buffer;
+        std::string_view folded = fold_case(language, buffer);
+        for (const LanguageExtension& entry : language_extensions) {
+            if (entry.language == folded) return entry.extension;
+        }
+        return {};
+    }
+}
+
+FileClassifier::FileClassifier(const std::filesystem::path& rootPath) {
+    parse_config(rootPath / ".aiifyrc");
+}
+
+void FileClassifier::parse_config(const std::filesystem::path& configPath) {
+    std::cout << "Parsing .aiifyrc file: " << configPath << std::endl;
+
+    if (!std::filesystem::exists(configPath)) {
+        std::cout << "No .aiifyrc file found. Using built-in file classification tables." << std::endl;
+        return;
+    }
+
+    std::ifstream file(configPath);
+    if (!file.is_open()) {
+        std::cerr << "Error: Unable to open .aiifyrc file." << std::endl;
+        return;
+    }
+
+    TableOverrides* section = nullptr;
+    bool in_ignore_section = false;
+    bool case_insensitive = false;
+    int entries = 0;
+    int line_number = 0;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        line_number++;
+        std::string entry(trim(line));
+        if (entry.empty() || entry[0] == '#') continue;
+
+        if (entry.front() == '[' && entry.back() == ']') {
+            std::string name = entry.substr(1, entry.size() - 2);
+            in_ignore_section = name == "ignore";
+            case_insensitive = name == "extensions" || name == "languages";
+            if (name == "extensions") section = &m_extensions;
+            else if (name == "filenames") section = &m_filenames;
+            else if (name == "ignore") section = &m_ignored;
+            else if (name == "languages") section = &m_languages;
+            else {
+                section = nullptr;
+                std::cerr << "Error parsing .aiifyrc line " << line_number << ": unknown section '" << entry << "'" << std::endl;
+            }
+            continue;
+        }
+
+        if (section == nullptr) {
+            std::cerr << "Error parsing .aiifyrc line " << line_number << ": entry outside of a known section" << std::endl;
+            continue;
+        }
+
+        bool negation = entry[0] == '!';
+        if (negation) {
+            entry = entry.substr(1);
+            if (entry == "*") {
+                section->builtins_enabled = false;
+                entries++;
+                continue;
+            }
+        }
+        if (entry.empty()) continue;
+
+        if (case_insensitive) {
+            std::transform(entry.begin(), entry.end(), entry.begin(), ::tolower);
+            if (section == &m_extensions && entry[0] != '.') {
+                entry.insert(entry.begin(), '.');
+            }
+            if (entry.size() > max_folded_length) {
+                std::cerr << "Error parsing .aiifyrc line " << line_number << ": entry longer than "
+                          << max_folded_length << " characters" << std::endl;
+                continue;
+            }
+        }
+
+        if (negation) {
+            section->removed.push_back(entry);
+        } else if (in_ignore_section && entry.find_first_of("*?") != std::string::npos) {
+            m_ignored_globs.push_back(entry);
+        } else {
+            section->added.push_back(entry);
+        }
+        entries++;
+    }
+
+    for (TableOverrides* table : { &m_extensions, &m_filenames, &m_ignored, &m_languages }) {
+        std::sort(table->added.begin(), table->added.end());
+        std::sort(table->removed.begin(), table->removed.end());
+    }
+
+    std::cout << "Finished parsing .aiifyrc. Total entries: " << entries << std::endl;
+}
+
+FileClassifier::Classification FileClassifier::classify(std::string_view filename) const {
+    if (is_ignored_filename(filename)) {
+        return Classification::Irrelevant;
+    }
+    if (is_relevant_filename(filename)) {
+        return Classification::Relevant;
+    }
+
+    // A leading dot counts as the extension, so ".gitignore" is looked up whole.
+    size_t dot = filename.rfind('.');
+    if (dot == std::string_view::npos) {
+        return Classification::NeedsSniff;
+    }
+    return is_relevant_extension(filename.substr(dot)) ? Classification::Relevant : Classification::Irrelevant;
+}
+
+std::optional<std::string_view> FileClassifier::script_extension(std::string_view header) const {
+    for (std::string_view language : { shebang_language(header), emacs_language(header), vim_filetype(header) }) {
+        if (is_script_language(language)) {
+            return extension_for_language(language);
+        }
+    }
+    return std::nullopt;
+}
+
+bool FileClassifier::is_relevant_extension(std::string_view extension) const {
+    std::array<char, max_folded_length> buffer;
+    std::string_view folded = fold_case(extension, buffer);
+    return m_extensions.matches(relevant_extension_set.contains(folded), folded);
+}
+
+bool FileClassifier::is_relevant_filename(std::string_view filename) const {
+    return m_filenames.matches(relevant_filename_set.contains(filename), filename);
+}
+
+bool FileClassifier::is_ignored_filename(std::string_view filename) const {
+    if (m_ignored.matches(ignored_filename_set.contains(filename), filename)) {
+        return true;
+    }
+
+    if (m_ignored.builtins_enabled) {
+        for (std::string_view pattern : ignored_globs) {
+            if (glob_match(pattern, filename) && !contains(m_ignored.removed, pattern)) {
+                return true;
+            }
+        }
+    }
+    for (const std::string& pattern : m_ignored_globs) {
+        if (glob_match(pattern, filename)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool FileClassifier::is_script_language(std::string_view language) const {
+    std::array<char, max_folded_length> buffer;
+    std::string_view folded = fold_case(language, buffer);
+    return m_languages.matches(script_language_set.contains(folded), folded);
+}
+
+bool FileClassifier::TableOverrides::matches(bool in_builtin_table, std::string_view key) const {
+    return (in_builtin_table && builtins_enabled && !FileClassifier::contains(removed, key))
+        || FileClassifier::contains(added, key);
+}
+
+bool FileClassifier::contains(const std::vector<std::string>& sorted, std::string_view key) {
+    return !sorted.empty() && std::binary_search(sorted.begin(), sorted.end(), key,
+        [](std::string_view a, std::string_view b) { return a < b; });
+}
+
+bool FileClassifier::glob_match(std::string_view pattern, std::string_view name) {
+    size_t p = 0, n = 0;
+    size_t star = std::string_view::npos, resume = 0;
+
+    while (n < name.size()) {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+            p++;
+            n++;
+        } else if (p < pattern.size() && pattern[p] == '*') {
+            star = p++;
+            resume = n;
+        } else if (star != std::string_view::npos) {
+            p = star + 1;
+            n = ++resume;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*') p++;
+    return p == pattern.size();
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Decides from a file's name alone whether it belongs in the output. The
+// built-in tables are compile-time perfect hash sets; an optional .aiifyrc in
+// the root directory can extend or override them. Extensionless files that no
+// table claims can be sniffed for a shebang or editor modeline.
+class FileClassifier {
+public:
+    enum class Classification { Relevant, Irrelevant, NeedsSniff };
+
+    // Number of leading bytes script_extension() expects to see.
+    static constexpr std::size_t header_size = 512;
+
+    FileClassifier(const std::filesystem::path& rootPath);
+    Classification classify(std::string_view filename) const;
+    // Sniffs a shebang or editor modeline in the first header_size bytes of a
+    // file. Returns nothing if the file is not a recognised script; otherwise
+    // an extension with the comment syntax of the script's language, or an
+    // empty view if that language has no known extension.
+    std::optional<std::string_view> script_extension(std::string_view header) const;
+
+private:
+    // Runtime changes to one built-in table, loaded from .aiifyrc. Both lists
+    // are kept sorted so lookups can binary search without allocating.
+    struct TableOverrides {
+        bool builtins_enabled = true;
+        std::vector<std::string> added;
+        std::vector<std::string> removed;
+
+        bool matches(bool in_builtin_table, std::string_view key) const;
+    };
+
+    TableOverrides m_extensions;
+    TableOverrides m_filenames;
+    TableOverrides m_ignored;
+    TableOverrides m_languages;
+    std::vector<std::string> m_ignored_globs;
+
+    void parse_config(const std::filesystem::path& configPath);
+    bool is_relevant_extension(std::string_view extension) const;
+    bool is_relevant_filename(std::string_view filename) const;
+    bool is_ignored_filename(std::string_view filename) const;
+    bool is_script_language(std::string_view language) const;
+    static bool contains(const std::vector<std::string>& sorted, std::string_view key);
+    static bool glob_match(std::string_view pattern, std::string_view name);
+};
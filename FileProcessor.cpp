@@ -1,39 +1,53 @@
 #include "FileProcessor.h"
+#include "AllocationTracker.h"
+#include "PerfectHashSet.h"
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <algorithm>
+#include <array>
 #include <stack>
 #include <iomanip>
-#include <regex>
-
-FileProcessor::FileProcessor(const GitignoreParser& parser) : m_gitignore_parser(parser) {
-    relevant_extensions = {
-        ".py", ".js", ".ts", ".jsx", ".tsx", ".html", ".css", ".scss", ".sass",
-        ".json", ".yaml", ".yml", ".xml", ".md", ".txt", ".csv",
-        ".cpp", ".hpp", ".c", ".h", ".java", ".kt", ".go", ".rs",
-        ".php", ".rb", ".pl", ".sql", ".sh", ".bat", ".ps1",
-        ".config", ".ini", ".env", ".gitignore", ".dockerignore",
-        "Dockerfile", "docker-compose.yml", "package.json", "requirements.txt",
-        "Gemfile", "Cargo.toml", "pom.xml", "build.gradle", "Makefile", ".svelte", ".env",
-        ".cs", ".csx", ".csproj", ".sln", ".resx", ".settings"
+#include <type_traits>
+
+using namespace std::literals;
+
+namespace {
+    // Streams a path in double quotes, escaping '"' and '\\' the way
+    // std::quoted does, without the string stream std::quoted builds.
+    struct QuotedPath {
+        std::string_view path;
     };
 
-    irrelevant_files = {
-        "package-lock.json", "yarn.lock", "Pipfile.lock", "poetry.lock",
-        "composer.lock", "Gemfile.lock", "Cargo.lock", "packages.config",
-        ".gitattributes", ".editorconfig", ".prettierrc", ".eslintrc",
-        "tsconfig.json", "tslint.json", "babel.config.js", "webpack.config.js",
-        "rollup.config.js", "vue.config.js", "nuxt.config.js", "next.config.js",
-        ".babelrc", ".npmrc", ".yarnrc", ".travis.yml", "appveyor.yml",
-        "circle.yml", "Jenkinsfile", ".gitlab-ci.yml", "sonar-project.properties",
-        "AssemblyInfo.cs", "*.designer.cs", "*.Designer.cs", "packages.config", "NuGet.Config", "project.json", "project.lock.json", "*.nuspec"
+    QuotedPath quoted_path(std::string_view path) {
+        return QuotedPath{ path };
+    }
+
+    std::ostream& operator<<(std::ostream& os, const QuotedPath& quoted) {
+        os << '"';
+        for (char c : quoted.path) {
+            if (c == '"' || c == '\\') os << '\\';
+            os << c;
+        }
+        return os << '"';
+    }
+
+    // Languages that start line comments with '#' and have no /* */ blocks.
+    constexpr std::array hash_comment_extensions{
+        ".sh"sv, ".rb"sv, ".pl"sv, ".tcl"sv, ".awk"sv, ".mk"sv, ".ps1"sv, ".r"sv, ".jl"sv,
+        ".exs"sv, ".conf"sv, ".yaml"sv, ".yml"sv, ".toml"sv, ".dockerfile"sv, ".cmake"sv
     };
 
+    constexpr PerfectHashSet<perfect_hash_slots(hash_comment_extensions.size())> hash_comment_extension_set(hash_comment_extensions);
+}
+
+FileProcessor::FileProcessor(const GitignoreParser& parser, const FileClassifier& classifier)
+    : m_gitignore_parser(parser), m_classifier(classifier) {
     minifiable_extensions = {
 
     };
 
+    m_input_stream.rdbuf()->pubsetbuf(m_input_buffer, sizeof(m_input_buffer));
+
     m_start_time = std::chrono::steady_clock::now();
 }
 
@@ -51,24 +65,46 @@ void FileProcessor::process_files(const std::filesystem::path& directory, const
     directoryStack.push(directory);
 
     while (!directoryStack.empty()) {
+        // Everything done for a directory is counted, including opening and
+        // iterating it, so the stats reflect the full per-file cost rather
+        // than just the content pipeline.
+        std::size_t allocations_before = AllocationTracker::allocation_count();
+
         std::filesystem::path currentDir = directoryStack.top();
         directoryStack.pop();
 
         for (const auto& entry : std::filesystem::directory_iterator(currentDir)) {
-            std::filesystem::path relativePath = std::filesystem::relative(entry.path(), directory);
-            
-            if (std::filesystem::is_directory(entry.path())) {
-                if (!m_gitignore_parser.should_ignore(entry.path())) {
+            std::size_t entry_allocations_before = AllocationTracker::allocation_count();
+            std::string_view relativePath = relative_path_of(entry.path(), directory);
+
+            // The entry caches its file type from the directory scan, so no extra stat is needed here.
+            if (entry.is_directory()) {
+                if (!m_gitignore_parser.should_ignore(relativePath, true)) {
                     directoryStack.push(entry.path());
                 } else {
                     m_ignored_files++;
                 }
-            } else if (std::filesystem::is_regular_file(entry.path())) {
+            } else if (entry.is_regular_file()) {
                 m_total_files++;
-                if (!m_gitignore_parser.should_ignore(entry.path()) && is_relevant_file(entry.path())) {
-                    std::cout << "\033[1;34m" << "[Processing] " << "\033[0m" << relativePath << "\n";
-                    outFile << "\nFile:" << relativePath.string() << "\nContents:";
-                    process_file_contents(entry.path(), outFile);
+                // The name-based verdict comes first: it is cheap, and irrelevant
+                // files never reach the gitignore rules or get opened.
+                FileClassifier::Classification classification = m_classifier.classify(filename_of(entry.path()));
+                bool relevant = classification != FileClassifier::Classification::Irrelevant &&
+                                !m_gitignore_parser.should_ignore(relativePath, false);
+
+                // A sniffed script has no extension of its own, so the one for
+                // its language decides how its comments are stripped.
+                std::optional<std::string_view> script_extension;
+                if (relevant && classification == FileClassifier::Classification::NeedsSniff) {
+                    script_extension = sniff_script(entry.path());
+                    relevant = script_extension.has_value();
+                }
+
+                if (relevant) {
+                    std::cout << "\033[1;34m" << "[Processing] " << "\033[0m" << quoted_path(relativePath) << "\n";
+                    outFile << "\nFile:" << relativePath << "\nContents:";
+                    process_file_contents(entry.path(), script_extension.value_or(std::string_view()), outFile);
+                    release_oversized_buffers();
                     outFile <<"\n--------------------------------";
                     m_processed_files++;
                 } else {
@@ -76,56 +112,106 @@ void FileProcessor::process_files(const std::filesystem::path& directory, const
                 }
             }
 
+            m_entry_allocations += AllocationTracker::allocation_count() - entry_allocations_before;
+
             if (m_total_files % 100 == 0) {
                 print_progress();
             }
         }
+
+        m_traversal_allocations += AllocationTracker::allocation_count() - allocations_before;
     }
 
     print_final_stats();
 }
 
-void FileProcessor::process_file_contents(const std::filesystem::path& file, std::ofstream& outFile) {
-    std::ifstream inFile(file, std::ios::binary);
-    if (inFile) {
-        std::string content((std::istreambuf_iterator<char>(inFile)), std::istreambuf_iterator<char>());
-        
-        if (content.empty()) {
-            outFile << "[Empty file]";
-            return;
-        }
+void FileProcessor::process_file_contents(const std::filesystem::path& file, std::string_view extension, std::ofstream& outFile) {
+    if (!read_file(file, m_content_buffer)) {
+        outFile << "[Unable to read file]";
+        return;
+    }
 
-        if (content.size() >= 3 && 
-            (unsigned char)content[0] == 0xEF &&
-            (unsigned char)content[1] == 0xBB &&
-            (unsigned char)content[2] == 0xBF) {
-            content = content.substr(3);
-        }
+    if (m_content_buffer.empty()) {
+        outFile << "[Empty file]";
+        return;
+    }
 
-        if (is_binary_content(content)) {
-            outFile << "[Binary file, contents not shown]";
-            return;
-        }
+    std::string_view content(m_content_buffer);
+    if (content.size() >= 3 &&
+        (unsigned char)content[0] == 0xEF &&
+        (unsigned char)content[1] == 0xBB &&
+        (unsigned char)content[2] == 0xBF) {
+        content.remove_prefix(3);
+    }
+
+    if (is_binary_content(content)) {
+        outFile << "[Binary file, contents not shown]";
+        return;
+    }
+
+    if (extension.empty()) {
+        m_extension_buffer = file.extension().string();
+        std::transform(m_extension_buffer.begin(), m_extension_buffer.end(), m_extension_buffer.begin(), ::tolower);
+        extension = m_extension_buffer;
+    }
+
+    // Each stage reads the current content and writes into the transform
+    // buffer; swapping the two buffers hands the result to the next stage.
+    auto apply_stage = [&](auto&& stage) {
+        stage(content, m_transform_buffer);
+        m_content_buffer.swap(m_transform_buffer);
+        content = m_content_buffer;
+    };
+
+    if (minifiable_extensions.find(extension) != minifiable_extensions.end()) {
+        apply_stage([&](std::string_view in, std::string& out) { minify_content(in, extension, out); });
+    }
+    apply_stage([&](std::string_view in, std::string& out) { remove_comments(in, extension, out); });
+    apply_stage([&](std::string_view in, std::string& out) { remove_empty_lines(in, out); });
+    apply_stage([&](std::string_view in, std::string& out) { standardize_indentation(in, out); });
+    apply_stage([&](std::string_view in, std::string& out) { remove_trailing_newlines(in, out); });
+    apply_stage([&](std::string_view in, std::string& out) { compress_newlines(in, out); });
 
-        std::string extension = file.extension().string();
-        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    outFile << content;
+}
 
-        if (minifiable_extensions.find(extension) != minifiable_extensions.end()) {
-            content = minify_content(content, extension);
+void FileProcessor::release_oversized_buffers() {
+    for (std::string* buffer : { &m_content_buffer, &m_transform_buffer }) {
+        if (buffer->capacity() > max_retained_capacity) {
+            std::string().swap(*buffer);
         }
-        content = remove_comments(content, extension);
-        content = remove_empty_lines(content);
-        content = standardize_indentation(content);
-        content = remove_trailing_newlines(content);
-        content = compress_newlines(content);
+    }
+}
 
-        outFile << content;
-    } else {
-        outFile << "[Unable to read file]";
+bool FileProcessor::read_file(const std::filesystem::path& file, std::string& out) {
+    out.clear();
+
+    // The stream object and its buffer outlive the file, so opening the next
+    // file does not allocate a fresh stream buffer.
+    std::ifstream& inFile = m_input_stream;
+    inFile.close();
+    inFile.clear();
+    inFile.open(file, std::ios::binary | std::ios::ate);
+    if (!inFile) {
+        return false;
+    }
+
+    std::streamoff size = inFile.tellg();
+    inFile.seekg(0, std::ios::beg);
+    if (size < 0 || !inFile) {
+        // Size is unknown (e.g. a pipe or special file); fall back to streaming.
+        inFile.clear();
+        out.assign(std::istreambuf_iterator<char>(inFile), std::istreambuf_iterator<char>());
+        return true;
     }
+
+    out.resize(static_cast<size_t>(size));
+    inFile.read(&out[0], size);
+    out.resize(static_cast<size_t>(inFile.gcount()));
+    return true;
 }
 
-bool FileProcessor::is_binary_content(const std::string& content) {
+bool FileProcessor::is_binary_content(std::string_view content) {
     const int checkBytes = std::min(static_cast<int>(content.size()), 1024);
     int textChars = 0;
 
@@ -142,76 +228,147 @@ bool FileProcessor::is_binary_content(const std::string& content) {
     return textChars < checkBytes * 0.9;
 }
 
-std::string FileProcessor::remove_comments(const std::string& content, const std::string& extension) {
-    std::string result = content;
-    
-    std::regex single_line_comment;
+void FileProcessor::remove_comments(std::string_view content, std::string_view extension, std::string& out) {
+    out.clear();
+
+    // Single-line comments are anchored to the end of the input (the behaviour
+    // of a non-multiline `//.*$`), so only a comment on the final line is stripped.
+    std::string_view single_line_marker = "//";
+    bool block_comments = true;
     if (extension == ".py") {
-        single_line_comment = std::regex(R"(#.*$)");
+        single_line_marker = "#";
+    } else if (hash_comment_extension_set.contains(extension)) {
+        single_line_marker = "#";
+        block_comments = false;
     } else if (extension == ".sql") {
-        single_line_comment = std::regex(R"(--.*$)");
-    } else {
-        single_line_comment = std::regex(R"(//.*$)");
+        single_line_marker = "--";
+    } else if (extension == ".lua") {
+        single_line_marker = "--";
+        block_comments = false;
+    } else if (extension == ".erl") {
+        single_line_marker = "%";
+        block_comments = false;
     }
-    result = std::regex_replace(result, single_line_comment, "");
 
-    std::regex multi_line_comment;
-    if (extension == ".py") {
-        multi_line_comment = std::regex(R"('''[\s\S]*?'''|"""[\s\S]*?""")");
-    } else {
-        multi_line_comment = std::regex(R"(/\*[\s\S]*?\*/)");
+    size_t last_line = content.find_last_of("\r\n");
+    last_line = (last_line == std::string_view::npos) ? 0 : last_line + 1;
+    size_t comment = content.find(single_line_marker, last_line);
+    if (comment != std::string_view::npos) {
+        content = content.substr(0, comment);
     }
-    result = std::regex_replace(result, multi_line_comment, "");
 
-    return result;
-}
+    // Multi-line comments: strip the leftmost complete block and continue after
+    // it. An opener without a matching closer is left in place.
+    size_t pos = 0;
+    if (extension == ".py") {
+        bool single_quotes_closable = true;
+        bool double_quotes_closable = true;
+
+        while (single_quotes_closable || double_quotes_closable) {
+            size_t open = std::string_view::npos;
+            size_t close = std::string_view::npos;
+
+            if (single_quotes_closable) {
+                size_t candidate = content.find("'''", pos);
+                size_t candidate_close = (candidate == std::string_view::npos) ? candidate : content.find("'''", candidate + 3);
+                if (candidate_close == std::string_view::npos) {
+                    single_quotes_closable = false;
+                } else {
+                    open = candidate;
+                    close = candidate_close;
+                }
+            }
+            if (double_quotes_closable) {
+                size_t candidate = content.find("\"\"\"", pos);
+                size_t candidate_close = (candidate == std::string_view::npos) ? candidate : content.find("\"\"\"", candidate + 3);
+                if (candidate_close == std::string_view::npos) {
+                    double_quotes_closable = false;
+                } else if (candidate < open) {
+                    open = candidate;
+                    close = candidate_close;
+                }
+            }
 
-std::string FileProcessor::minify_content(const std::string& content, const std::string& extension) {
-    std::string result = content;
+            if (open == std::string_view::npos) break;
+            out.append(content, pos, open - pos);
+            pos = close + 3;
+        }
+    } else if (block_comments) {
+        while (true) {
+            size_t open = content.find("/*", pos);
+            if (open == std::string_view::npos) break;
+            size_t close = content.find("*/", open + 2);
+            if (close == std::string_view::npos) break;
+            out.append(content, pos, open - pos);
+            pos = close + 2;
+        }
+    }
+    out.append(content, pos, std::string_view::npos);
+}
 
-    result = std::regex_replace(result, std::regex(R"(^\s+|\s+$)"), "");
-    result = std::regex_replace(result, std::regex(R"(\s+)"), " ");
+void FileProcessor::minify_content(std::string_view content, std::string_view extension, std::string& out) {
+    out.clear();
+
+    // Data formats lose all whitespace; everything else has each whitespace
+    // run collapsed to a single space. Both ends are trimmed either way.
+    const bool drop_whitespace = extension == ".json" || extension == ".xml" || extension == ".yaml" || extension == ".yml";
+    bool pending_space = false;
+    for (char c : content) {
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r') {
+            pending_space = !out.empty();
+            continue;
+        }
+        if (pending_space && !drop_whitespace) out += ' ';
+        pending_space = false;
+        out += c;
+    }
 
     if (extension == ".html" || extension == ".svg") {
-        result = std::regex_replace(result, std::regex(R"(<!--[\s\S]*?-->)"), "");
-    } else if (extension == ".json" || extension == ".xml" || extension == ".yaml" || extension == ".yml") {
-        result = std::regex_replace(result, std::regex(R"(\s+)"), "");
-    } else if (extension == ".md") {
-        result = std::regex_replace(result, std::regex(R"([ \t]+)"), " ");
-        result = std::regex_replace(result, std::regex(R"(\n\s+)"), "\n");
+        // Strip complete <!-- --> comments by compacting the buffer in place.
+        size_t read = 0;
+        size_t write = 0;
+        while (true) {
+            size_t open = out.find("<!--", read);
+            size_t close = (open == std::string::npos) ? open : out.find("-->", open + 4);
+            size_t keep_end = (close == std::string::npos) ? out.size() : open;
+            std::copy(out.begin() + read, out.begin() + keep_end, out.begin() + write);
+            write += keep_end - read;
+            if (close == std::string::npos) break;
+            read = close + 3;
+        }
+        out.resize(write);
     }
-
-    return result;
 }
 
-std::string FileProcessor::remove_empty_lines(const std::string& content) {
-    std::istringstream iss(content);
-    std::ostringstream oss;
-    std::string line;
+void FileProcessor::remove_empty_lines(std::string_view content, std::string& out) {
+    out.clear();
     bool first_line = true;
 
-    while (std::getline(iss, line)) {
-        line = trim(line);
+    size_t pos = 0;
+    while (pos < content.size()) {
+        size_t end = std::min(content.find('\n', pos), content.size());
+        std::string_view line = trim(content.substr(pos, end - pos));
+        pos = end + 1;
+
         if (!line.empty()) {
-            if (!first_line) oss << ' ';
-            oss << line;
+            if (!first_line) out += ' ';
+            out += line;
             first_line = false;
         }
     }
-
-    return oss.str();
 }
 
-std::string FileProcessor::standardize_indentation(const std::string& content) {
-    std::istringstream iss(content);
-    std::ostringstream oss;
-    std::string line;
+void FileProcessor::standardize_indentation(std::string_view content, std::string& out) {
+    out.clear();
     int indentLevel = 0;
     const int spacesPerIndent = 2;
     bool first_line = true;
 
-    while (std::getline(iss, line)) {
-        line = trim(line);
+    size_t pos = 0;
+    while (pos < content.size()) {
+        size_t end = std::min(content.find('\n', pos), content.size());
+        std::string_view line = trim(content.substr(pos, end - pos));
+        pos = end + 1;
         if (line.empty()) continue;
 
         for (char c : line) {
@@ -219,47 +376,89 @@ std::string FileProcessor::standardize_indentation(const std::string& content) {
             else if (c == '}' || c == ']' || c == ')') indentLevel = std::max(0, indentLevel - 1);
         }
 
-        if (!first_line) oss << ' ';
-        oss << std::string(indentLevel * spacesPerIndent, ' ') << line;
+        if (!first_line) out += ' ';
+        out.append(static_cast<size_t>(indentLevel * spacesPerIndent), ' ');
+        out += line;
         first_line = false;
 
-        if (!line.empty() && (line[0] == '}' || line[0] == ']' || line[0] == ')')) {
+        if (line[0] == '}' || line[0] == ']' || line[0] == ')') {
             indentLevel = std::max(0, indentLevel - 1);
         }
     }
-
-    return oss.str();
 }
 
-std::string FileProcessor::remove_trailing_newlines(const std::string& content) {
-    return std::regex_replace(content, std::regex("\\s+$"), "");
+void FileProcessor::remove_trailing_newlines(std::string_view content, std::string& out) {
+    size_t last = content.find_last_not_of(" \t\n\v\f\r");
+    out.assign(content.data(), (last == std::string_view::npos) ? 0 : last + 1);
 }
 
-std::string FileProcessor::compress_newlines(const std::string& content) {
-    return std::regex_replace(content, std::regex("\\n\\s*\\n+"), "\n");
+void FileProcessor::compress_newlines(std::string_view content, std::string& out) {
+    // Collapses each newline followed by whitespace containing further
+    // newlines down to a single newline.
+    out.clear();
+
+    size_t pos = 0;
+    size_t newline = content.find('\n');
+    while (newline != std::string_view::npos) {
+        size_t run_end = std::min(content.find_first_not_of(" \t\n\v\f\r", newline + 1), content.size());
+        size_t last_newline = content.find_last_of('\n', run_end - 1);
+
+        if (last_newline > newline) {
+            out.append(content, pos, newline - pos);
+            out += '\n';
+            pos = last_newline + 1;
+        }
+        newline = content.find('\n', std::max(newline + 1, pos));
+    }
+    out.append(content, pos, std::string_view::npos);
 }
 
-std::string FileProcessor::trim(const std::string& str) {
+std::string_view FileProcessor::trim(std::string_view str) {
     size_t first = str.find_first_not_of(" \t");
-    if (std::string::npos == first) return "";
+    if (std::string_view::npos == first) return {};
     size_t last = str.find_last_not_of(" \t");
     return str.substr(first, (last - first + 1));
 }
 
-bool FileProcessor::is_relevant_file(const std::filesystem::path& file) const {
-    std::string filename = file.filename().string();
-    std::string extension = file.extension().string();
-    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
-    
-    if (irrelevant_files.find(filename) != irrelevant_files.end()) {
-        return false;
+std::string_view FileProcessor::filename_of(const std::filesystem::path& file) {
+    if constexpr (std::is_same_v<std::filesystem::path::value_type, char>) {
+        // Narrow native paths can be viewed in place without building a path for filename().
+        std::string_view native(file.native());
+        size_t separator = native.find_last_of('/');
+        return separator == std::string_view::npos ? native : native.substr(separator + 1);
+    } else {
+        m_filename_buffer = file.filename().string();
+        return m_filename_buffer;
     }
-    
-    if (extension.empty() && relevant_extensions.find(filename) != relevant_extensions.end()) {
-        return true;
+}
+
+std::string_view FileProcessor::relative_path_of(const std::filesystem::path& file, const std::filesystem::path& root) {
+    if constexpr (std::is_same_v<std::filesystem::path::value_type, char>) {
+        // Entries come from iterating below the root, so their native path starts
+        // with the root's; stripping it avoids the canonicalization relative() does.
+        std::string_view native(file.native());
+        std::string_view rootNative(root.native());
+        if (native.substr(0, rootNative.size()) == rootNative) {
+            native.remove_prefix(rootNative.size());
+            while (!native.empty() && native.front() == '/') native.remove_prefix(1);
+            return native;
+        }
     }
-    
-    return relevant_extensions.find(extension) != relevant_extensions.end();
+    m_relative_buffer = file.lexically_relative(root).string();
+    return m_relative_buffer;
+}
+
+std::optional<std::string_view> FileProcessor::sniff_script(const std::filesystem::path& file) {
+    std::ifstream& inFile = m_input_stream;
+    inFile.close();
+    inFile.clear();
+    inFile.open(file, std::ios::binary);
+    if (!inFile) {
+        return std::nullopt;
+    }
+
+    inFile.read(m_header_buffer, sizeof(m_header_buffer));
+    return m_classifier.script_extension(std::string_view(m_header_buffer, static_cast<size_t>(inFile.gcount())));
 }
 
 void FileProcessor::print_progress() {
@@ -283,5 +482,9 @@ void FileProcessor::print_final_stats() {
     std::cout << "Files processed:      " << std::setw(8) << m_processed_files << "\n";
     std::cout << "Files ignored:        " << std::setw(8) << m_ignored_files << "\n";
     std::cout << "Total time:           " << std::setw(8) << duration << " seconds\n";
+    std::cout << "Allocations per file: " << std::setw(8) << std::fixed << std::setprecision(2)
+              << (m_total_files > 0 ? static_cast<double>(m_traversal_allocations) / m_total_files : 0.0) << "\n";
+    std::cout << "  excl. dir iteration:" << std::setw(8) << std::fixed << std::setprecision(2)
+              << (m_total_files > 0 ? static_cast<double>(m_entry_allocations) / m_total_files : 0.0) << "\n";
     std::cout << "------------------------------\n";
 }
\ No newline at end of file
@@ -1,38 +1,65 @@
 #pragma once
 
 #include "GitignoreParser.h"
+#include "FileClassifier.h"
 #include <filesystem>
+#include <fstream>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <set>
+#include <functional>
 #include <chrono>
 
 class FileProcessor {
 public:
-    FileProcessor(const GitignoreParser& parser);
+    FileProcessor(const GitignoreParser& parser, const FileClassifier& classifier);
     void process_files(const std::filesystem::path& directory, const std::filesystem::path& outputFile);
 
 private:
     const GitignoreParser& m_gitignore_parser;
-    std::set<std::string> relevant_extensions;
-    std::set<std::string> irrelevant_files;
-    std::set<std::string> minifiable_extensions;
+    const FileClassifier& m_classifier;
+    std::set<std::string, std::less<>> minifiable_extensions;
     
     int m_total_files = 0;
     int m_processed_files = 0;
     int m_ignored_files = 0;
+    // Allocations made while walking the tree, with and without the cost of
+    // std::filesystem opening directories and building each entry's path.
+    std::size_t m_traversal_allocations = 0;
+    std::size_t m_entry_allocations = 0;
     std::chrono::steady_clock::time_point m_start_time;
 
-    void process_file_contents(const std::filesystem::path& file, std::ofstream& outFile);
-    bool is_relevant_file(const std::filesystem::path& file) const;
+    // Scratch buffers reused for every file. They are cleared between files but
+    // keep their capacity, so once they have grown to the largest file seen the
+    // transform pipeline no longer touches the heap. A single huge file should
+    // not pin that much memory for the rest of the run, so any buffer that grew
+    // past max_retained_capacity is released once the file is written.
+    static constexpr std::size_t max_retained_capacity = 4 * 1024 * 1024;
+    std::string m_content_buffer;
+    std::string m_transform_buffer;
+    std::string m_extension_buffer;
+    std::string m_filename_buffer;
+    std::string m_relative_buffer;
+    std::ifstream m_input_stream;
+    char m_input_buffer[8192];
+    char m_header_buffer[FileClassifier::header_size];
+
+    void process_file_contents(const std::filesystem::path& file, std::string_view extension, std::ofstream& outFile);
+    bool read_file(const std::filesystem::path& file, std::string& out);
+    void release_oversized_buffers();
+    std::string_view filename_of(const std::filesystem::path& file);
+    std::string_view relative_path_of(const std::filesystem::path& file, const std::filesystem::path& root);
+    std::optional<std::string_view> sniff_script(const std::filesystem::path& file);
     void print_progress();
     void print_final_stats();
 
-    bool is_binary_content(const std::string& content);
-    std::string remove_comments(const std::string& content, const std::string& extension);
-    std::string minify_content(const std::string& content, const std::string& extension);
-    std::string remove_empty_lines(const std::string& content);
-    std::string standardize_indentation(const std::string& content);
-    std::string remove_trailing_newlines(const std::string& content);
-    std::string trim(const std::string& str);
-    std::string compress_newlines(const std::string& content);
+    bool is_binary_content(std::string_view content);
+    void remove_comments(std::string_view content, std::string_view extension, std::string& out);
+    void minify_content(std::string_view content, std::string_view extension, std::string& out);
+    void remove_empty_lines(std::string_view content, std::string& out);
+    void standardize_indentation(std::string_view content, std::string& out);
+    void remove_trailing_newlines(std::string_view content, std::string& out);
+    static std::string_view trim(std::string_view str);
+    void compress_newlines(std::string_view content, std::string& out);
 };
\ No newline at end of file
@@ -43,11 +43,10 @@ void GitignoreParser::parse_gitignore(const std::filesystem::path& gitignorePath
         // Convert backslashes to forward slashes for consistency
         std::replace(line.begin(), line.end(), '\\', '/');
 
-        try {
-            rule.pattern = std::regex(glob_to_regex(line), std::regex::ECMAScript);
+        if (compile_glob(line, false, rule)) {
             rules.push_back(rule);
-        } catch (const std::regex_error& e) {
-            std::cerr << "Error parsing rule '" << line << "': " << e.what() << std::endl;
+        } else {
+            std::cerr << "Error parsing rule '" << line << "': malformed character class" << std::endl;
         }
     }
 
@@ -173,9 +172,8 @@ void GitignoreParser::add_default_ignores() {
             pattern_copy.pop_back();
         }
         
-        // Add start and end anchors to the regex
-        std::string regex_pattern = "^" + glob_to_regex(pattern_copy) + "$";
-        rule.pattern = std::regex(regex_pattern, std::regex::ECMAScript);
+        // Default patterns must match the whole path
+        compile_glob(pattern_copy, true, rule);
         rules.push_back(rule);
     }
 
@@ -184,12 +182,14 @@ void GitignoreParser::add_default_ignores() {
 
 bool GitignoreParser::should_ignore(const std::filesystem::path& path) const {
     std::filesystem::path relativePath = std::filesystem::relative(path, rootPath);
-    std::string pathStr = relativePath.generic_string();
+    return should_ignore(relativePath.generic_string(), std::filesystem::is_directory(path));
+}
 
+bool GitignoreParser::should_ignore(std::string_view relativePath, bool is_directory) const {
     bool ignored = false;
 
     for (const auto& rule : rules) {
-        if (match_rule(relativePath, rule)) {
+        if (match_rule(relativePath, is_directory, rule)) {
             ignored = !rule.negation;
         }
     }
@@ -200,9 +200,10 @@ bool GitignoreParser::should_ignore(const std::filesystem::path& path) const {
 bool GitignoreParser::should_skip_directory(const std::filesystem::path& path) const {
     std::filesystem::path relativePath = std::filesystem::relative(path, rootPath);
     std::string pathStr = relativePath.generic_string();
+    bool is_directory = std::filesystem::is_directory(path);
 
     for (const auto& rule : rules) {
-        if (rule.is_directory && match_rule(relativePath, rule)) {
+        if (rule.is_directory && match_rule(pathStr, is_directory, rule)) {
             return !rule.negation;
         }
     }
@@ -210,53 +211,131 @@ bool GitignoreParser::should_skip_directory(const std::filesystem::path& path) c
     return false;
 }
 
-bool GitignoreParser::match_rule(const std::filesystem::path& path, const IgnoreRule& rule) const {
-    std::string pathStr = path.generic_string();
-    // Normalize path separators
-    std::replace(pathStr.begin(), pathStr.end(), '\\', '/');
-    
-    if (rule.is_directory && !std::filesystem::is_directory(rootPath / path)) {
+namespace {
+    // Reads byte `pos` of the path being matched, with backslashes normalized
+    // to '/' and an optional '/' appended after the last byte.
+    unsigned char path_byte(std::string_view path, size_t pos) {
+        if (pos >= path.size()) return '/';
+        return path[pos] == '\\' ? '/' : static_cast<unsigned char>(path[pos]);
+    }
+}
+
+bool GitignoreParser::match_rule(std::string_view path, bool is_directory, const IgnoreRule& rule) {
+    if (rule.is_directory && !is_directory) {
         return false;
     }
-    
-    // If the rule ends with '/', add it to the path string for matching
-    if (rule.is_directory && pathStr.back() != '/') {
-        pathStr += '/';
+
+    // If the rule ends with '/', match against the path with a '/' appended
+    bool trailing_slash = rule.is_directory && (path.empty() || path_byte(path, path.size() - 1) != '/');
+    size_t length = path.size() + (trailing_slash ? 1 : 0);
+
+    if (!rule.anchored) {
+        for (size_t start = 0; start <= length; ++start) {
+            if (match_tokens(rule.pattern, 0, path, trailing_slash, start, false)) return true;
+        }
+        return false;
     }
-    
-    return std::regex_search(pathStr, rule.pattern);
+
+    if (match_tokens(rule.pattern, 0, path, trailing_slash, 0, true)) {
+        return true;
+    }
+    if (rule.any_directory) {
+        for (size_t pos = 0; pos < length; ++pos) {
+            if (path_byte(path, pos) == '/' && match_tokens(rule.pattern, 0, path, trailing_slash, pos + 1, true)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool GitignoreParser::match_tokens(const std::vector<GlobToken>& tokens, size_t token, std::string_view path,
+                                   bool trailing_slash, size_t pos, bool whole) {
+    size_t length = path.size() + (trailing_slash ? 1 : 0);
+
+    while (token < tokens.size()) {
+        const GlobToken& current = tokens[token];
+        if (current.repeat) {
+            // Try the shortest run first, then one byte longer each time
+            for (size_t end = pos; ; ++end) {
+                if (match_tokens(tokens, token + 1, path, trailing_slash, end, whole)) return true;
+                if (end == length || !current.chars[path_byte(path, end)]) return false;
+            }
+        }
+
+        if (pos == length || !current.chars[path_byte(path, pos)]) {
+            return false;
+        }
+        ++token;
+        ++pos;
+    }
+
+    return !whole || pos == length;
 }
 
-std::string GitignoreParser::glob_to_regex(const std::string& glob) {
-    std::string regex;
-    bool in_brackets = false;
+bool GitignoreParser::compile_glob(const std::string& glob, bool anchored, IgnoreRule& rule) {
+    rule.pattern.clear();
+    rule.anchored = anchored;
+    rule.any_directory = glob.find('/') == std::string::npos && glob[0] != '*';
+
+    std::bitset<256> not_slash;
+    not_slash.set();
+    not_slash.reset('/');
+    std::bitset<256> not_newline;
+    not_newline.set();
+    not_newline.reset('\n');
+    not_newline.reset('\r');
 
     for (size_t i = 0; i < glob.length(); ++i) {
         char c = glob[i];
-        switch (c) {
-            case '*':
-                if (i + 1 < glob.length() && glob[i + 1] == '*') {
-                    regex += ".*";
-                    ++i;
+        if (c == '*' && i + 1 < glob.length() && glob[i + 1] == '*') {
+            rule.pattern.push_back({ not_newline, true });
+            ++i;
+        } else if (c == '*') {
+            rule.pattern.push_back({ not_slash, true });
+        } else if (c == '?') {
+            rule.pattern.push_back({ not_slash, false });
+        } else if (c == '[') {
+            // Character class: an optional leading '^' negates it, and "a-z"
+            // style ranges are allowed. Every other byte stands for itself.
+            size_t close = glob.find(']', i + 1);
+            if (close == std::string::npos) {
+                return false;
+            }
+
+            std::string members;
+            for (size_t j = i + 1; j < close; ++j) {
+                if (glob[j] == '*' && j + 1 < close && glob[j + 1] == '*') {
+                    members += ".*";
+                    ++j;
                 } else {
-                    regex += in_brackets ? "*" : "[^/]*";
+                    members += glob[j];
                 }
-                break;
-            case '?':
-                regex += in_brackets ? "?" : "[^/]";
-                break;
-            case '.': regex += "\\."; break;
-            case '\\': regex += "\\\\"; break;
-            case '/': regex += "\\/"; break;
-            case '[': in_brackets = true; regex += "["; break;
-            case ']': in_brackets = false; regex += "]"; break;
-            default: regex += c;
-        }
-    }
+            }
 
-    if (glob.find('/') == std::string::npos && glob[0] != '*') {
-        regex = "(.*/)?" + regex;
+            bool negated = !members.empty() && members[0] == '^';
+            std::bitset<256> chars;
+            for (size_t j = negated ? 1 : 0; j < members.size(); ++j) {
+                unsigned char first = static_cast<unsigned char>(members[j]);
+                if (j + 2 < members.size() && members[j + 1] == '-') {
+                    unsigned char last = static_cast<unsigned char>(members[j + 2]);
+                    if (first > last) {
+                        return false;
+                    }
+                    for (unsigned int b = first; b <= last; ++b) chars.set(b);
+                    j += 2;
+                } else {
+                    chars.set(first);
+                }
+            }
+            rule.pattern.push_back({ negated ? ~chars : chars, false });
+            i = close;
+        } else {
+            std::bitset<256> chars;
+            chars.set(static_cast<unsigned char>(c));
+            rule.pattern.push_back({ chars, false });
+        }
     }
 
-    return regex;
+    return true;
 }
\ No newline at end of file
@@ -1,18 +1,28 @@
 #pragma once
+#include <bitset>
 #include <filesystem>
 #include <vector>
 #include <string>
-#include <regex>
+#include <string_view>
 
 class GitignoreParser {
 public:
     GitignoreParser(const std::filesystem::path& rootPath);
     bool should_ignore(const std::filesystem::path& path) const;
+    bool should_ignore(std::string_view relativePath, bool is_directory) const;
     bool should_skip_directory(const std::filesystem::path& path) const;
 
 private:
+    // One step of a compiled glob: a set of accepted bytes, matched either
+    // exactly once or any number of times.
+    struct GlobToken {
+        std::bitset<256> chars;
+        bool repeat;
+    };
     struct IgnoreRule {
-        std::regex pattern;
+        std::vector<GlobToken> pattern;
+        bool anchored;       // must match the whole path rather than any part of it
+        bool any_directory;  // may also start right after any '/' in the path
         bool is_directory;
         bool negation;
     };
@@ -20,6 +30,8 @@ private:
     std::filesystem::path rootPath;
     void parse_gitignore(const std::filesystem::path& gitignorePath);
     void add_default_ignores();
-    static std::string glob_to_regex(const std::string& glob);
-    bool match_rule(const std::filesystem::path& path, const IgnoreRule& rule) const;
+    static bool compile_glob(const std::string& glob, bool anchored, IgnoreRule& rule);
+    static bool match_rule(std::string_view path, bool is_directory, const IgnoreRule& rule);
+    static bool match_tokens(const std::vector<GlobToken>& tokens, size_t token, std::string_view path,
+                             bool trailing_slash, size_t pos, bool whole);
 };
\ No newline at end of file
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+// Smallest power-of-two slot count that keeps a table of `keys` entries at
+// most half full.
+constexpr std::size_t perfect_hash_slots(std::size_t keys) {
+    std::size_t slots = 2;
+    while (slots < 2 * keys) slots <<= 1;
+    return slots;
+}
+
+// Fixed set of strings laid out with a perfect hash at compile time, using
+// hash-and-displace: the low half of a key's hash picks a bucket, and the
+// bucket's displacement moves the high half onto a free slot. A lookup is one
+// hash, two table reads and one string comparison.
+template <std::size_t Slots>
+class PerfectHashSet {
+    static_assert(Slots >= 2 && (Slots & (Slots - 1)) == 0, "Slots must be a power of two");
+    static_assert(Slots <= 65536, "Displacements are stored as 16-bit values");
+
+    static constexpr std::size_t Buckets = Slots / 2;
+
+public:
+    template <std::size_t N>
+    constexpr explicit PerfectHashSet(const std::array<std::string_view, N>& keys)
+        : m_slots{}, m_displacements{}, m_seed(0) {
+        static_assert(N <= Slots, "More keys than slots");
+
+        for (std::uint32_t seed = 1; seed < 1024; ++seed) {
+            if (build(keys, seed)) {
+                m_seed = seed;
+                return;
+            }
+        }
+        throw std::logic_error("No perfect hash seed found; increase Slots");
+    }
+
+    constexpr bool contains(std::string_view key) const {
+        std::uint64_t h = hash(key, m_seed);
+        return !key.empty() && m_slots[slot_of(h, m_displacements[bucket_of(h)])] == key;
+    }
+
+private:
+    std::array<std::string_view, Slots> m_slots;
+    std::array<std::uint16_t, Buckets> m_displacements;
+    std::uint32_t m_seed;
+
+    static constexpr std::uint64_t hash(std::string_view key, std::uint32_t seed) {
+        std::uint64_t h = 14695981039346656037ull ^ (seed * 0x9E3779B97F4A7C15ull);
+        for (char c : key) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 1099511628211ull;
+        }
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        return h ^ (h >> 33);
+    }
+
+    static constexpr std::size_t bucket_of(std::uint64_t h) {
+        return static_cast<std::size_t>(h) & (Buckets - 1);
+    }
+
+    static constexpr std::size_t slot_of(std::uint64_t h, std::size_t displacement) {
+        return (static_cast<std::size_t>(h >> 32) + displacement) & (Slots - 1);
+    }
+
+    template <std::size_t N>
+    constexpr bool build(const std::array<std::string_view, N>& keys, std::uint32_t seed) {
+        m_slots = {};
+        m_displacements = {};
+
+        // Repeated and empty keys are skipped so they cannot collide with themselves.
+        std::array<bool, N> skip{};
+        std::array<std::uint64_t, N> hashes{};
+        std::array<std::size_t, Buckets> bucket_sizes{};
+        std::size_t largest_bucket = 0;
+        for (std::size_t i = 0; i < N; ++i) {
+            skip[i] = keys[i].empty();
+            for (std::size_t j = 0; j < i && !skip[i]; ++j) {
+                skip[i] = keys[j] == keys[i];
+            }
+            if (skip[i]) continue;
+
+            hashes[i] = hash(keys[i], seed);
+            std::size_t size = ++bucket_sizes[bucket_of(hashes[i])];
+            if (size > largest_bucket) largest_bucket = size;
+        }
+
+        // Placing the fullest buckets first leaves the easy ones for when the
+        // table is crowded.
+        for (std::size_t size = largest_bucket; size > 0; --size) {
+            for (std::size_t bucket = 0; bucket < Buckets; ++bucket) {
+                if (bucket_sizes[bucket] == size && !place_bucket(keys, skip, hashes, bucket)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    template <std::size_t N>
+    constexpr bool place_bucket(const std::array<std::string_view, N>& keys, const std::array<bool, N>& skip,
+                                const std::array<std::uint64_t, N>& hashes, std::size_t bucket) {
+        for (std::size_t displacement = 0; displacement < Slots; ++displacement) {
+            bool placed = true;
+            for (std::size_t i = 0; i < N && placed; ++i) {
+                if (skip[i] || bucket_of(hashes[i]) != bucket) continue;
+                std::string_view& slot = m_slots[slot_of(hashes[i], displacement)];
+                if (slot.empty()) {
+                    slot = keys[i];
+                } else {
+                    placed = false;
+                }
+            }
+            if (placed) {
+                m_displacements[bucket] = static_cast<std::uint16_t>(displacement);
+                return true;
+            }
+
+            // Undo the keys this attempt managed to place before the collision.
+            for (std::size_t i = 0; i < N; ++i) {
+                if (skip[i] || bucket_of(hashes[i]) != bucket) continue;
+                std::string_view& slot = m_slots[slot_of(hashes[i], displacement)];
+                if (slot == keys[i]) slot = {};
+            }
+        }
+        return false;
+    }
+};
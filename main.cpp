@@ -1,6 +1,7 @@
 #include <iostream>
 #include <filesystem>
 #include "GitignoreParser.h"
+#include "FileClassifier.h"
 #include "FileProcessor.h"
 
 // Include Windows-specific header
@@ -59,8 +60,11 @@ int main(int argc, char* argv[]) {
     std::cout << "Initializing GitignoreParser..." << std::endl;
     GitignoreParser gitignore_parser(directory_path);
     
+    std::cout << "Initializing FileClassifier..." << std::endl;
+    FileClassifier file_classifier(directory_path);
+
     std::cout << "Initializing FileProcessor..." << std::endl;
-    FileProcessor file_processor(gitignore_parser);
+    FileProcessor file_processor(gitignore_parser, file_classifier);
 
     try {
         std::cout << "Starting file processing..." << std::endl;